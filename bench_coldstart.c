@@ -0,0 +1,89 @@
+#include "rb_malloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+/*
+ * Cold-start allocation latency.
+ * Usage: ./bench_coldstart [none|reserve|prefault] [count] [size]
+ * Each allocation is timed together with its first write, so page faults
+ * on fresh heap memory show up in the numbers.
+ */
+
+static long long now_ns(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long minor_faults(void)
+{
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        return ru.ru_minflt;
+}
+
+static int cmp_ll(const void *a, const void *b)
+{
+        long long x = *(const long long *)a, y = *(const long long *)b;
+        return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+        const char *mode = argc > 1 ? argv[1] : "none";
+        int count = argc > 2 ? atoi(argv[2]) : 10000;
+        size_t size = argc > 3 ? (size_t)atol(argv[3]) : 256;
+        if (count <= 0 || size == 0) {
+                fprintf(stderr, "bad count or size\n");
+                return 1;
+        }
+
+        // Samples live on the system heap so they don't touch rb's heap
+        long long *lat = malloc(sizeof(*lat) * (size_t)count);
+        if (!lat) {
+                return 1;
+        }
+
+        size_t reserve = (size_t)count * (size + 64);
+        long long init_ns = 0;
+        if (strcmp(mode, "none") != 0) {
+                int flags = strcmp(mode, "prefault") == 0 ? RB_INIT_PREFAULT : 0;
+                long long t0 = now_ns();
+                if (rb_init(reserve, flags) != 0) {
+                        fprintf(stderr, "rb_init failed\n");
+                        return 1;
+                }
+                init_ns = now_ns() - t0;
+        }
+
+        long faults0 = minor_faults();
+        long long total0 = now_ns();
+        for (int i = 0; i < count; i++) {
+                long long t0 = now_ns();
+                char *p = rb_malloc(size);
+                if (!p) {
+                        fprintf(stderr, "rb_malloc failed at %d\n", i);
+                        return 1;
+                }
+                memset(p, 0xab, size);
+                lat[i] = now_ns() - t0;
+        }
+        long long total = now_ns() - total0;
+        long faults = minor_faults() - faults0;
+
+        qsort(lat, (size_t)count, sizeof(*lat), cmp_ll);
+        printf("mode=%s count=%d size=%zu\n", mode, count, size);
+        printf("  init      %lld ns\n", init_ns);
+        printf("  total     %lld ns\n", total);
+        printf("  p50       %lld ns\n", lat[count / 2]);
+        printf("  p99       %lld ns\n", lat[(size_t)count * 99 / 100]);
+        printf("  max       %lld ns\n", lat[count - 1]);
+        printf("  minflt    %ld\n", faults);
+
+        free(lat);
+        return 0;
+}
@@ -1,7 +1,24 @@
 #include "rb_malloc.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+        printf("%s: %s\n", ok ? "ok" : "FAIL", what);
+        if (!ok) {
+                failures++;
+        }
+}
+
+static int in_range(void *p, char *lo, char *hi)
+{
+        return (char *)p >= lo && (char *)p < hi;
+}
 
 int main(void)
 {
@@ -39,6 +56,49 @@ int main(void)
         void *x = rb_malloc(16);
         printf("new block x reused? %p\n", x);
 
+        printf("=== Reserve ===\n");
+
+        // Move the break so a reservation inherited from RB_MALLOC_RESERVE
+        // isn't contiguous; the first rb_init below then drops it.
+        sbrk(64);
+        char *base = sbrk(0);
+        check(rb_init(4096, RB_INIT_PREFAULT) == 0, "rb_init reserves 4096");
+        char *end = base + 4096;
+
+        char *a = rb_malloc(64);
+        check(in_range(a, base, end) && sbrk(0) == end,
+              "small block carved from reservation without sbrk");
+
+        check(rb_init(4096, 0) == 0 && sbrk(0) == end + 4096,
+              "rb_init reserves another 4096");
+        end += 4096;
+        char *wide = rb_malloc(6000);
+        check(in_range(wide, a, end) && sbrk(0) == end,
+              "contiguous rb_init extends the reservation");
+
+        char *big = rb_malloc(8192);
+        check(big && !in_range(big, base, end) && (char *)sbrk(0) > end,
+              "oversized block falls back to sbrk");
+
+        char *b = rb_malloc(64);
+        check(in_range(b, wide, end), "reservation still used after fallback");
+
+        char *brk = sbrk(0);
+        check(rb_init(0, 0) == 0 && sbrk(0) == brk, "rb_init(0) is a no-op");
+        check(rb_init(SIZE_MAX, 0) == -1 && sbrk(0) == brk,
+              "oversized rb_init fails without moving the break");
+        char *c = rb_malloc(64);
+        check(in_range(c, b, end),
+              "reservation unchanged after no-op and failed rb_init");
+
+        char *base2 = sbrk(0);
+        check(rb_init(4096, 0) == 0, "non-contiguous rb_init reserves 4096");
+        char *d = rb_malloc(16);
+        check(!in_range(d, base, end), "old tail is not handed out whole");
+        char *e = rb_malloc(1024);
+        check(in_range(e, base2, base2 + 4096),
+              "non-contiguous rb_init starts a fresh reservation");
+
         printf("=== Done ===\n");
-        return 0;
+        return failures ? 1 : 0;
 }
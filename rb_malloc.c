@@ -1,10 +1,15 @@
 #include <assert.h>
+#include <ctype.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#include "rb_malloc.h"
+
 enum { RED = 0, BLACK = 1 };
 enum { ALLOCATED = 0, FREE = 1 };
 
@@ -26,9 +31,19 @@ struct meta {
 
 static struct meta *root = NULL;
 
+/*
+ * Pre-reserved heap region. issue_space carves new blocks from
+ * [reserve_cur, reserve_end) before falling back to sbrk.
+ */
+static char *reserve_cur = NULL;
+static char *reserve_end = NULL;
+static int env_checked = 0;
+
 /* ---------- Forward decls ---------- */
 static struct meta *find_free(size_t size);
 static struct meta *issue_space(size_t size);
+static struct meta *carve_reserve(size_t size);
+static void init_from_env(void);
 static void insert_rb(struct meta *node);
 static void rb_insert_fixup(struct meta *z);
 static void rotate_left(struct meta *x);
@@ -47,7 +62,7 @@ static void print_tree(struct meta *node, int depth);
  */
 void *rb_malloc(size_t size)
 {
-        if (size == 0) {
+        if (size == 0 || size > SIZE_MAX - (sizeof(void *) - 1)) {
                 return NULL;
         }
 
@@ -172,6 +187,19 @@ static struct meta *find_free(size_t need)
  */
 static struct meta *issue_space(size_t size)
 {
+        // Fallback if the load-time constructor didn't run
+        if (!env_checked) {
+                init_from_env();
+        }
+        struct meta *carved = carve_reserve(size);
+        if (carved) {
+                return carved;
+        }
+
+        // sbrk takes a signed increment, so the block must fit in intptr_t
+        if (size > (size_t)INTPTR_MAX - sizeof(struct meta)) {
+                return NULL;
+        }
         void *prev_brk = sbrk(0);
         if (prev_brk == (void *)-1) {
                 return NULL;
@@ -188,6 +216,146 @@ static struct meta *issue_space(size_t size)
         return block;
 }
 
+/*
+ * @brief Reserve heap space up front so early allocations skip sbrk.
+ * @param size Number of bytes to reserve (rounded up to pointer size).
+ * @param flags RB_INIT_PREFAULT to touch every page of the reservation.
+ * @return 0 on success, -1 if size is too large or the heap could not grow.
+ */
+int rb_init(size_t size, int flags)
+{
+        if (size == 0) {
+                return 0;
+        }
+        // sbrk takes a signed increment; larger sizes would shrink the heap
+        if (size > (size_t)INTPTR_MAX - sizeof(void *)) {
+                return -1;
+        }
+        size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+        void *base = sbrk(size);
+        if (base == (void *)-1) {
+                return -1;
+        }
+        env_checked = 1; // a real reservation takes precedence over the env
+        char *new_end = (char *)base + size;
+        if (reserve_cur && (char *)base == reserve_end) {
+                // Contiguous with the current reservation: just extend it
+                reserve_end = new_end;
+        } else {
+                // Drop any old tail. Blocks are never split, so putting it in
+                // the tree would hand the whole tail to one small request.
+                reserve_cur = (char *)base;
+                reserve_end = new_end;
+        }
+
+        if (flags & RB_INIT_PREFAULT) {
+                long page = sysconf(_SC_PAGESIZE);
+                if (page <= 0) {
+                        page = 4096;
+                }
+                // sbrk memory can't be MAP_POPULATE'd, so hint then touch
+                uintptr_t start = (uintptr_t)base & ~((uintptr_t)page - 1);
+                madvise((void *)start, (uintptr_t)new_end - start,
+                        MADV_WILLNEED);
+                for (volatile char *c = base; c < new_end; c += page) {
+                        *c = 0;
+                }
+                *(volatile char *)(new_end - 1) = 0;
+        }
+        return 0;
+}
+
+/*
+ * @brief Initialize the reservation from RB_MALLOC_RESERVE and
+ * RB_MALLOC_PREFAULT. Sizes accept a k/m/g suffix; invalid values are
+ * ignored.
+ */
+static void init_from_env(void)
+{
+        env_checked = 1;
+        const char *val = getenv("RB_MALLOC_RESERVE");
+        if (!val || !*val) {
+                return;
+        }
+        // strtoull would accept a sign or leading space, so require a digit
+        if (!isdigit((unsigned char)*val)) {
+                return;
+        }
+        char *end;
+        errno = 0;
+        unsigned long long bytes = strtoull(val, &end, 10);
+        if (errno == ERANGE) {
+                return;
+        }
+        int shift = 0;
+        switch (*end) {
+        case 'g':
+        case 'G':
+                shift = 30;
+                end++;
+                break;
+        case 'm':
+        case 'M':
+                shift = 20;
+                end++;
+                break;
+        case 'k':
+        case 'K':
+                shift = 10;
+                end++;
+                break;
+        default:
+                break;
+        }
+        // Ignore trailing garbage and values that overflow the shift
+        if (*end != '\0' || bytes > (SIZE_MAX >> shift)) {
+                return;
+        }
+        bytes <<= shift;
+
+        const char *pf = getenv("RB_MALLOC_PREFAULT");
+        int flags = (pf && *pf && *pf != '0') ? RB_INIT_PREFAULT : 0;
+        rb_init((size_t)bytes, flags);
+}
+
+/*
+ * @brief Apply the environment settings at load time, so the sbrk and
+ * prefault cost isn't paid inside the first rb_malloc.
+ */
+__attribute__((constructor)) static void init_at_load(void)
+{
+        if (!env_checked) {
+                init_from_env();
+        }
+}
+
+/*
+ * @brief Carve a new block off the front of the reservation.
+ * @param size Size of the memory block to allocate.
+ * @return Pointer to the new block, or NULL if the reservation is too small.
+ */
+static struct meta *carve_reserve(size_t size)
+{
+        if (!reserve_cur) {
+                return NULL;
+        }
+        // Too big: leave the reservation for later, smaller requests.
+        // Compare without adding so huge sizes can't wrap.
+        size_t left = (size_t)(reserve_end - reserve_cur);
+        if (left < sizeof(struct meta) || size > left - sizeof(struct meta)) {
+                return NULL;
+        }
+
+        struct meta *block = (struct meta *)reserve_cur;
+        reserve_cur += sizeof(struct meta) + size;
+        block->size = size;
+        block->l = block->r = block->p = NULL;
+        block->color = RED;
+        block->state = ALLOCATED;
+        return block;
+}
+
 static int less(struct meta *a, struct meta *b)
 {
         if (a->size != b->size) {
@@ -33,6 +33,20 @@ void *rb_realloc(void *ptr, size_t size);
  */
 void *rb_calloc(size_t count, size_t size);
 
+/** Flag for rb_init: touch every reserved page so first use doesn't fault. */
+#define RB_INIT_PREFAULT 0x1
+
+/**
+ * @brief Reserve heap space up front so early allocations take no syscalls.
+ * RB_MALLOC_RESERVE (bytes, k/m/g suffix) and RB_MALLOC_PREFAULT=1 are
+ * applied at load time, before main. A later call extends the reservation
+ * if the heap is still contiguous with it, and drops its tail otherwise.
+ * @param size Number of bytes to reserve.
+ * @param flags 0 or RB_INIT_PREFAULT.
+ * @return 0 on success, -1 on failure.
+ */
+int rb_init(size_t size, int flags);
+
 /**
  * @brief Print the contents of the red-black tree. Debugging purposes.
  * @return void